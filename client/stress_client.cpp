@@ -4,60 +4,90 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <poll.h>
 #include <ctime>
+#include <cerrno>
 #include <chrono>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "socket_address.h"
+#include "workload_trace.h"
 
 #define BUFFER_SIZE 4096
 #define DEFAULT_PORT 8888
 #define DEFAULT_MESSAGE_SIZE 1024
 #define DEFAULT_MESSAGE_COUNT 10000
+#define REPLAY_LATE_THRESHOLD_US 1000
+#define REPLAY_START_LEAD_MS 100
+#define SEND_WINDOW_SIZE (64 * 1024)
 
-class StressClient
+// 统计数据，回放模式下每条连接各持有一份，结束后合并
+struct RunStats
 {
-private:
-    std::string server_ip;
-    int port;
-    int message_size;
-    int message_count;
-
-    // 统计数据
     std::vector<double> latencies;
     unsigned long long total_bytes_sent;
     unsigned long long total_bytes_received;
     int successful_messages;
     int failed_messages;
+    int late_messages; // 回放时未能按计划时间发送的消息数
+
+    RunStats()
+        : total_bytes_sent(0), total_bytes_received(0),
+          successful_messages(0), failed_messages(0), late_messages(0)
+    {
+    }
+
+    void merge(const RunStats &other)
+    {
+        latencies.insert(latencies.end(), other.latencies.begin(), other.latencies.end());
+        total_bytes_sent += other.total_bytes_sent;
+        total_bytes_received += other.total_bytes_received;
+        successful_messages += other.successful_messages;
+        failed_messages += other.failed_messages;
+        late_messages += other.late_messages;
+    }
+};
+
+class StressClient
+{
+private:
+    SocketAddress server_addr;
+    int message_size;
+    int message_count;
+
+    // 轨迹回放参数，trace_path为空时使用固定长度消息模式
+    std::string trace_path;
+    int connection_count; // 0表示与轨迹中的连接数相同
+    double replay_speed;  // 0表示以最快速度回放
+
+    // 回放线程的统一起跑信号
+    std::mutex start_mutex;
+    std::condition_variable start_cond;
+    bool start_ready;
+    std::chrono::steady_clock::time_point replay_start;
+
+    RunStats stats;
 
     // 连接到服务器
     int connectToServer()
     {
         /**
-         * AF_INET: IPv4协议
+         * family: AF_INET / AF_INET6 / AF_UNIX，由地址描述决定
          * SOCK_STREAM: 提供有序、可靠、双向、基于连接的字节流。
          * 0: 给定套接字类型的默认协议
          **/
-        int sock_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int sock_fd = socket(server_addr.family(), SOCK_STREAM, 0);
         if (sock_fd == -1)
         {
             perror("socket");
             return -1;
         }
 
-        struct sockaddr_in server_addr;
-        memset(&server_addr, 0, sizeof(server_addr));
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_port = htons(port);
-
-        // 转换IP地址
-        if (inet_pton(AF_INET, server_ip.c_str(), &server_addr.sin_addr) <= 0)
-        {
-            std::cerr << "Invalid address: " << server_ip << std::endl;
-            close(sock_fd);
-            return -1;
-        }
-
-        if (connect(sock_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1)
+        if (connect(sock_fd, (const struct sockaddr *)&server_addr.addr, server_addr.addr_len) == -1)
         {
             perror("connect");
             close(sock_fd);
@@ -68,45 +98,77 @@ private:
     }
 
     // 发送并接收数据
-    bool sendAndReceive(int sock_fd, const char *message, int msg_len, double &latency)
+    bool sendAndReceive(int sock_fd, const char *message, int msg_len, char *buffer,
+                        RunStats &st, double &latency)
     {
         auto start = std::chrono::high_resolution_clock::now();
 
-        // 发送消息
+        /**
+         * 边发送边接收回显：服务端同步回显，若先写完整条大消息再读，
+         * 双方的套接字缓冲区都会被填满而互相阻塞。
+         * 未读回显最多 SEND_WINDOW_SIZE 字节，确保能被套接字缓冲区容纳。
+         **/
         ssize_t sent = 0;
-        while (sent < msg_len)
+        ssize_t received = 0;
+        while (received < msg_len)
         {
-            ssize_t n = write(sock_fd, message + sent, msg_len - sent);
-            if (n <= 0)
+            struct pollfd pfd;
+            pfd.fd = sock_fd;
+            pfd.events = POLLIN;
+            if (sent < msg_len && sent - received < SEND_WINDOW_SIZE)
             {
-                perror("write");
+                pfd.events |= POLLOUT;
+            }
+            pfd.revents = 0;
+
+            if (poll(&pfd, 1, -1) == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                perror("poll");
                 return false;
             }
-            sent += n;
-        }
-        total_bytes_sent += sent;
 
-        // 接收回显
-        char buffer[BUFFER_SIZE];
-        ssize_t received = 0;
-        while (received < msg_len)
-        {
-            ssize_t n = read(sock_fd, buffer + received, msg_len - received);
-            if (n <= 0)
+            // 发送消息
+            if (pfd.revents & POLLOUT)
             {
+                size_t len = std::min((ssize_t)SEND_WINDOW_SIZE - (sent - received), msg_len - sent);
+                ssize_t n = send(sock_fd, message + sent, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (n == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+                {
+                    perror("write");
+                    return false;
+                }
+                if (n > 0)
+                {
+                    sent += n;
+                }
+            }
+
+            // 接收回显
+            if (pfd.revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                ssize_t n = recv(sock_fd, buffer + received, msg_len - received, MSG_DONTWAIT);
                 if (n == 0)
                 {
                     std::cerr << "Server closed connection" << std::endl;
+                    return false;
                 }
-                else
+                if (n == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
                 {
                     perror("read");
+                    return false;
+                }
+                if (n > 0)
+                {
+                    received += n;
                 }
-                return false;
             }
-            received += n;
         }
-        total_bytes_received += received;
+        st.total_bytes_sent += sent;
+        st.total_bytes_received += received;
 
         auto end = std::chrono::high_resolution_clock::now();
         latency = std::chrono::duration<double, std::milli>(end - start).count();
@@ -121,20 +183,183 @@ private:
         return true;
     }
 
+    // 填充消息内容
+    static void fillMessage(char *message, int len)
+    {
+        for (int i = 0; i < len; i++)
+        {
+            message[i] = 'A' + (i % 26);
+        }
+    }
+
+    // 在一条连接上按轨迹的时间间隔回放消息
+    void replayConnection(const WorkloadTrace &trace, uint32_t conn, int sock_fd, const char *message,
+                          RunStats &st)
+    {
+        std::vector<char> buffer(trace.maxMessageSize());
+
+        // 等待所有线程就绪后统一开始
+        std::chrono::steady_clock::time_point start;
+        {
+            std::unique_lock<std::mutex> lock(start_mutex);
+            while (!start_ready)
+            {
+                start_cond.wait(lock);
+            }
+            start = replay_start;
+        }
+        std::this_thread::sleep_until(start);
+
+        const TraceRecord *records = trace.connectionRecords(conn);
+        uint64_t count = trace.connectionRecordCount(conn);
+        double offset_us = 0;
+
+        for (uint64_t i = 0; i < count; i++)
+        {
+            // 按绝对时间调度，避免累积误差；落后于计划时立即发送
+            if (replay_speed > 0)
+            {
+                offset_us += records[i].gap_us / replay_speed;
+                std::chrono::steady_clock::time_point due =
+                    start + std::chrono::microseconds((long long)offset_us);
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                if (now < due)
+                {
+                    std::this_thread::sleep_until(due);
+                }
+                else if (now - due > std::chrono::microseconds(REPLAY_LATE_THRESHOLD_US))
+                {
+                    st.late_messages++;
+                }
+            }
+
+            double latency;
+            if (sendAndReceive(sock_fd, message, records[i].size, buffer.data(), st, latency))
+            {
+                st.successful_messages++;
+                st.latencies.push_back(latency);
+            }
+            else
+            {
+                // 连接已不可用，剩余消息全部计为失败
+                st.failed_messages += count - i;
+                break;
+            }
+        }
+    }
+
+    // 轨迹回放模式：每条连接一个线程
+    int runTrace()
+    {
+        WorkloadTrace trace;
+        if (!trace.open(trace_path))
+        {
+            return -1;
+        }
+
+        if (connection_count <= 0)
+        {
+            connection_count = trace.connectionCount();
+        }
+
+        std::cout << "Loaded trace " << trace_path << ": " << trace.connectionCount() << " connections, "
+                  << trace.recordCount() << " records" << std::endl;
+        std::cout << "Opening " << connection_count << " connections to server "
+                  << server_addr.spec << "..." << std::endl;
+
+        std::vector<int> sockets;
+        for (int i = 0; i < connection_count; i++)
+        {
+            int sock_fd = connectToServer();
+            if (sock_fd == -1)
+            {
+                for (size_t j = 0; j < sockets.size(); j++)
+                {
+                    close(sockets[j]);
+                }
+                return -1;
+            }
+            sockets.push_back(sock_fd);
+        }
+
+        std::cout << "Connected! Starting trace replay..." << std::endl;
+
+        // 所有连接共享同一份只读消息内容
+        std::vector<char> message(trace.maxMessageSize());
+        fillMessage(message.data(), message.size());
+
+        // 连接数多于轨迹中的连接时循环复用
+        std::vector<RunStats> conn_stats(connection_count);
+        std::vector<std::thread> threads;
+        std::chrono::steady_clock::time_point start_time;
+        {
+            // 先创建全部线程，再发布统一的起始时间，避免启动慢的线程被计为落后
+            std::unique_lock<std::mutex> lock(start_mutex);
+            start_ready = false;
+            for (int i = 0; i < connection_count; i++)
+            {
+                uint32_t conn = i % trace.connectionCount();
+                conn_stats[i].latencies.reserve(trace.connectionRecordCount(conn));
+                threads.push_back(std::thread(&StressClient::replayConnection, this, std::cref(trace), conn,
+                                              sockets[i], message.data(), std::ref(conn_stats[i])));
+            }
+
+            replay_start = std::chrono::steady_clock::now() + std::chrono::milliseconds(REPLAY_START_LEAD_MS);
+            start_time = replay_start;
+            start_ready = true;
+        }
+        start_cond.notify_all();
+
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+
+        std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
+        double total_time = std::chrono::duration<double>(end_time - start_time).count();
+
+        for (int i = 0; i < connection_count; i++)
+        {
+            close(sockets[i]);
+            stats.merge(conn_stats[i]);
+        }
+
+        // 计算并打印统计信息
+        calculateStats(total_time);
+
+        return (stats.failed_messages == 0) ? 0 : 1;
+    }
+
     // 计算并打印统计信息
     void calculateStats(double total_time)
     {
         std::cout << "\n========== Stress Test Results ==========" << std::endl;
-        std::cout << "Server: " << server_ip << ":" << port << std::endl;
-        std::cout << "Message size: " << message_size << " bytes" << std::endl;
-        std::cout << "Total messages: " << message_count << std::endl;
-        std::cout << "Successful: " << successful_messages << std::endl;
-        std::cout << "Failed: " << failed_messages << std::endl;
+        std::cout << "Server: " << server_addr.spec << std::endl;
+        if (trace_path.empty())
+        {
+            std::cout << "Message size: " << message_size << " bytes" << std::endl;
+            std::cout << "Total messages: " << message_count << std::endl;
+        }
+        else
+        {
+            std::cout << "Trace: " << trace_path << std::endl;
+            std::cout << "Connections: " << connection_count << std::endl;
+            std::cout << "Replay speed: ";
+            if (replay_speed > 0)
+                std::cout << replay_speed << "x" << std::endl;
+            else
+                std::cout << "max" << std::endl;
+            std::cout << "Total messages: " << (stats.successful_messages + stats.failed_messages) << std::endl;
+            std::cout << "Late sends: " << stats.late_messages << std::endl;
+        }
+        std::cout << "Successful: " << stats.successful_messages << std::endl;
+        std::cout << "Failed: " << stats.failed_messages << std::endl;
         std::cout << "Total time: " << total_time << " seconds" << std::endl;
 
-        if (successful_messages > 0)
+        if (stats.successful_messages > 0)
         {
             // 计算延迟统计数据
+            std::vector<double> &latencies = stats.latencies;
             std::sort(latencies.begin(), latencies.end());
 
             double sum = 0;
@@ -158,9 +383,9 @@ private:
             std::cout << "Max:     " << max_latency << std::endl;
 
             std::cout << "\n--- Throughput ---" << std::endl;
-            std::cout << "Messages/sec: " << (successful_messages / total_time) << std::endl;
-            std::cout << "Sent:     " << (total_bytes_sent / total_time / 1024.0) << " KB/s" << std::endl;
-            std::cout << "Received: " << (total_bytes_received / total_time / 1024.0) << " KB/s" << std::endl;
+            std::cout << "Messages/sec: " << (stats.successful_messages / total_time) << std::endl;
+            std::cout << "Sent:     " << (stats.total_bytes_sent / total_time / 1024.0) << " KB/s" << std::endl;
+            std::cout << "Received: " << (stats.total_bytes_received / total_time / 1024.0) << " KB/s" << std::endl;
         }
 
         std::cout << "========================================\n"
@@ -168,17 +393,29 @@ private:
     }
 
 public:
-    StressClient(const std::string &ip, int p, int msg_size, int msg_count)
-        : server_ip(ip), port(p), message_size(msg_size), message_count(msg_count),
-          total_bytes_sent(0), total_bytes_received(0),
-          successful_messages(0), failed_messages(0)
+    StressClient(const SocketAddress &addr, int msg_size, int msg_count)
+        : server_addr(addr), message_size(msg_size), message_count(msg_count),
+          connection_count(0), replay_speed(1.0), start_ready(false)
     {
-        latencies.reserve(msg_count);
+        stats.latencies.reserve(msg_count);
+    }
+
+    // 切换到轨迹回放模式
+    void setTrace(const std::string &path, int connections, double speed)
+    {
+        trace_path = path;
+        connection_count = connections;
+        replay_speed = speed;
     }
 
     int run()
     {
-        std::cout << "Connecting to server " << server_ip << ":" << port << "..." << std::endl;
+        if (!trace_path.empty())
+        {
+            return runTrace();
+        }
+
+        std::cout << "Connecting to server " << server_addr.spec << "..." << std::endl;
 
         int sock_fd = connectToServer();
         if (sock_fd == -1)
@@ -192,10 +429,8 @@ public:
 
         // 准备消息数据
         char *message = new char[message_size];
-        for (int i = 0; i < message_size; i++)
-        {
-            message[i] = 'A' + (i % 26);
-        }
+        fillMessage(message, message_size);
+        char buffer[BUFFER_SIZE];
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -204,14 +439,14 @@ public:
         {
             double latency;
 
-            if (sendAndReceive(sock_fd, message, message_size, latency))
+            if (sendAndReceive(sock_fd, message, message_size, buffer, stats, latency))
             {
-                successful_messages++;
-                latencies.push_back(latency);
+                stats.successful_messages++;
+                stats.latencies.push_back(latency);
             }
             else
             {
-                failed_messages++;
+                stats.failed_messages++;
                 std::cerr << "Message " << (i + 1) << " failed" << std::endl;
             }
 
@@ -231,7 +466,7 @@ public:
         // 计算并打印统计信息
         calculateStats(total_time);
 
-        return (failed_messages == 0) ? 0 : 1;
+        return (stats.failed_messages == 0) ? 0 : 1;
     }
 };
 
@@ -239,8 +474,14 @@ int main(int argc, char *argv[])
 {
     std::string server_ip = "127.0.0.1";
     int port = DEFAULT_PORT;
+    std::string address;
     int message_size = DEFAULT_MESSAGE_SIZE;
     int message_count = DEFAULT_MESSAGE_COUNT;
+    std::string trace_path;
+    int connection_count = 0;
+    double replay_speed = 1.0;
+    bool size_or_count_set = false;
+    bool speed_set = false;
 
     // 解析命令行参数
     for (int i = 1; i < argc; i++)
@@ -253,13 +494,40 @@ int main(int argc, char *argv[])
         {
             port = atoi(argv[++i]);
         }
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+        {
+            // 与服务端相同的地址描述，优先于 -h/-p
+            address = argv[++i];
+        }
         else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
         {
             message_size = atoi(argv[++i]);
+            size_or_count_set = true;
         }
         else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
         {
             message_count = atoi(argv[++i]);
+            size_or_count_set = true;
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            connection_count = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+        {
+            // 回放倍速，"max"表示不等待间隔
+            const char *speed = argv[++i];
+            replay_speed = (strcmp(speed, "max") == 0) ? 0 : atof(speed);
+            if (replay_speed <= 0 && strcmp(speed, "max") != 0)
+            {
+                std::cerr << "Invalid replay speed (must be > 0 or max)" << std::endl;
+                return 1;
+            }
+            speed_set = true;
         }
         else
         {
@@ -286,6 +554,41 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    StressClient client(server_ip, port, message_size, message_count);
+    if (connection_count < 0)
+    {
+        std::cerr << "Invalid connection count" << std::endl;
+        return 1;
+    }
+
+    // 回放参数只在轨迹模式下有效，消息长度和数量由轨迹决定
+    if ((connection_count > 0 || speed_set) && trace_path.empty())
+    {
+        std::cerr << "Options -c and -x require a trace (-t)" << std::endl;
+        return 1;
+    }
+
+    if (size_or_count_set && !trace_path.empty())
+    {
+        std::cerr << "Options -s and -n cannot be used with a trace (-t)" << std::endl;
+        return 1;
+    }
+
+    if (address.empty())
+    {
+        address = "tcp4:" + server_ip + ":" + std::to_string(port);
+    }
+
+    SocketAddress server_addr;
+    if (!parseSocketAddress(address, false, server_addr))
+    {
+        std::cerr << "Invalid address: " << address << std::endl;
+        return 1;
+    }
+
+    StressClient client(server_addr, message_size, message_count);
+    if (!trace_path.empty())
+    {
+        client.setTrace(trace_path, connection_count, replay_speed);
+    }
     return client.run();
 }
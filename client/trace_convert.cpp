@@ -0,0 +1,344 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "workload_trace.h"
+
+#define DEFAULT_CONNECTIONS 16
+#define DEFAULT_MESSAGE_COUNT 10000
+#define DEFAULT_PARETO_ALPHA 1.5
+#define DEFAULT_MIN_SIZE 64
+#define DEFAULT_MAX_SIZE 4096
+#define DEFAULT_RATE 1000.0
+
+// 以连接号分组的消息记录
+typedef std::map<uint32_t, std::vector<TraceRecord>> ConnectionRecords;
+
+static bool endsWith(const std::string &s, const std::string &suffix)
+{
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// 校验并追加一条记录
+static bool addRecord(ConnectionRecords &conns, long long conn, long long size, long long gap_us, int line_no)
+{
+    if (conn < 0 || conn > UINT32_MAX)
+    {
+        std::cerr << "Line " << line_no << ": invalid connection id" << std::endl;
+        return false;
+    }
+    if (size <= 0 || size > MAX_TRACE_MESSAGE_SIZE)
+    {
+        std::cerr << "Line " << line_no << ": invalid size (must be 1-" << MAX_TRACE_MESSAGE_SIZE << ")" << std::endl;
+        return false;
+    }
+    if (gap_us < 0 || gap_us > UINT32_MAX)
+    {
+        std::cerr << "Line " << line_no << ": invalid gap_us" << std::endl;
+        return false;
+    }
+
+    TraceRecord rec;
+    rec.size = (uint32_t)size;
+    rec.gap_us = (uint32_t)gap_us;
+    conns[(uint32_t)conn].push_back(rec);
+    return true;
+}
+
+// 从JSON对象中取出整数字段，例如 "size": 512
+static bool jsonField(const std::string &line, const char *key, long long &value)
+{
+    std::string quoted = std::string("\"") + key + "\"";
+    size_t pos = line.find(quoted);
+    if (pos == std::string::npos)
+        return false;
+    pos = line.find(':', pos + quoted.size());
+    if (pos == std::string::npos)
+        return false;
+
+    const char *start = line.c_str() + pos + 1;
+    char *end;
+    errno = 0;
+    value = strtoll(start, &end, 10);
+    if (end == start || errno != 0)
+        return false;
+
+    // 拒绝小数等非整数值，与文本格式一样不接受多余字符
+    while (*end == ' ' || *end == '\t' || *end == '\r')
+        end++;
+    return *end == ',' || *end == '}' || *end == '\0';
+}
+
+/**
+ * 文本格式：每行 "<conn> <size> <gap_us>"，'#' 开头为注释
+ * JSONL格式：每行 {"conn": 0, "size": 512, "gap_us": 1000}
+ **/
+static bool parseDescription(const std::string &path, bool jsonl, ConnectionRecords &conns)
+{
+    std::ifstream in(path.c_str());
+    if (!in)
+    {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(in, line))
+    {
+        line_no++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        long long conn, size, gap_us;
+        if (jsonl)
+        {
+            if (!jsonField(line, "conn", conn) || !jsonField(line, "size", size) ||
+                !jsonField(line, "gap_us", gap_us))
+            {
+                std::cerr << "Line " << line_no << ": expected \"conn\", \"size\" and \"gap_us\" fields" << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::istringstream fields(line);
+            std::string extra;
+            if (!(fields >> conn >> size >> gap_us) || (fields >> extra))
+            {
+                std::cerr << "Line " << line_no << ": expected \"<conn> <size> <gap_us>\"" << std::endl;
+                return false;
+            }
+        }
+
+        if (!addRecord(conns, conn, size, gap_us, line_no))
+            return false;
+    }
+
+    if (conns.empty())
+    {
+        std::cerr << "No records in " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 合成负载：消息长度服从Pareto分布（截断到max_size），
+ * 到达过程为Poisson过程（指数分布间隔）；rate为0时背靠背发送。
+ **/
+static void generateSynthetic(ConnectionRecords &conns, int connections, int message_count,
+                              double alpha, int min_size, int max_size, double rate, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::exponential_distribution<double> arrivals(rate > 0 ? rate : 1.0);
+
+    for (int c = 0; c < connections; c++)
+    {
+        std::vector<TraceRecord> &records = conns[c];
+        records.reserve(message_count);
+        for (int i = 0; i < message_count; i++)
+        {
+            // 逆变换采样：x = xm / U^(1/alpha)，U取(0,1]
+            double u = 1.0 - uniform(rng);
+            double size = min_size / std::pow(u, 1.0 / alpha);
+
+            TraceRecord rec;
+            rec.size = (uint32_t)std::min(size, (double)max_size);
+            rec.gap_us = 0;
+            if (rate > 0)
+            {
+                double gap = arrivals(rng) * 1e6;
+                rec.gap_us = (uint32_t)std::min(gap, (double)UINT32_MAX);
+            }
+            records.push_back(rec);
+        }
+    }
+}
+
+// 写出二进制轨迹文件，连接号按升序重新编号为0..N-1
+static bool writeTrace(const std::string &path, const ConnectionRecords &conns)
+{
+    TraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.connection_count = conns.size();
+
+    std::vector<TraceConnection> index;
+    index.reserve(conns.size());
+    for (ConnectionRecords::const_iterator it = conns.begin(); it != conns.end(); ++it)
+    {
+        TraceConnection conn;
+        conn.first_record = header.record_count;
+        conn.record_count = it->second.size();
+        index.push_back(conn);
+        header.record_count += it->second.size();
+
+        for (size_t i = 0; i < it->second.size(); i++)
+        {
+            header.max_message_size = std::max(header.max_message_size, it->second[i].size);
+        }
+    }
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Cannot create " << path << std::endl;
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(TraceConnection));
+    for (ConnectionRecords::const_iterator it = conns.begin(); it != conns.end(); ++it)
+    {
+        out.write(reinterpret_cast<const char *>(it->second.data()), it->second.size() * sizeof(TraceRecord));
+    }
+
+    if (!out)
+    {
+        std::cerr << "Write to " << path << " failed" << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote " << path << ": " << header.connection_count << " connections, "
+              << header.record_count << " records, max message size "
+              << header.max_message_size << " bytes" << std::endl;
+    return true;
+}
+
+static void usage(const char *prog)
+{
+    std::cerr << "Usage:\n"
+              << "  " << prog << " -i <description> [-f text|jsonl] -o <trace>\n"
+              << "  " << prog << " -o <trace> [-c connections] [-n messages] [-a pareto_alpha]\n"
+              << "      [-s min_size] [-S max_size] [-r rate_per_conn] [-e seed]\n"
+              << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string input_path;
+    std::string output_path;
+    std::string format;
+    int connections = DEFAULT_CONNECTIONS;
+    int message_count = DEFAULT_MESSAGE_COUNT;
+    double alpha = DEFAULT_PARETO_ALPHA;
+    int min_size = DEFAULT_MIN_SIZE;
+    int max_size = DEFAULT_MAX_SIZE;
+    double rate = DEFAULT_RATE;
+    unsigned seed = 1;
+
+    // 解析命令行参数
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            input_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            format = argv[++i];
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            connections = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            message_count = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+        {
+            alpha = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            min_size = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc)
+        {
+            max_size = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            rate = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+        {
+            seed = strtoul(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (output_path.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ConnectionRecords conns;
+    if (!input_path.empty())
+    {
+        if (format.empty())
+        {
+            format = endsWith(input_path, ".jsonl") ? "jsonl" : "text";
+        }
+        if (format != "text" && format != "jsonl")
+        {
+            std::cerr << "Invalid format (must be text or jsonl)" << std::endl;
+            return 1;
+        }
+        if (!parseDescription(input_path, format == "jsonl", conns))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        if (connections <= 0 || message_count <= 0)
+        {
+            std::cerr << "Invalid connection or message count" << std::endl;
+            return 1;
+        }
+        if (alpha <= 0)
+        {
+            std::cerr << "Invalid Pareto shape (must be > 0)" << std::endl;
+            return 1;
+        }
+        if (min_size <= 0 || max_size < min_size || max_size > MAX_TRACE_MESSAGE_SIZE)
+        {
+            std::cerr << "Invalid size range (must be 1-" << MAX_TRACE_MESSAGE_SIZE << ")" << std::endl;
+            return 1;
+        }
+        if (rate < 0)
+        {
+            std::cerr << "Invalid rate" << std::endl;
+            return 1;
+        }
+        generateSynthetic(conns, connections, message_count, alpha, min_size, max_size, rate, seed);
+    }
+
+    return writeTrace(output_path, conns) ? 0 : 1;
+}
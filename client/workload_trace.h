@@ -0,0 +1,182 @@
+#ifndef WORKLOAD_TRACE_H
+#define WORKLOAD_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * 负载轨迹文件格式（小端，本机字节序，所有字段自然对齐）：
+ *
+ *   TraceHeader
+ *   TraceConnection[connection_count]   每条连接在记录数组中的区间
+ *   TraceRecord[record_count]           按连接连续存放的消息记录
+ *
+ * 文件由 trace_convert 生成，stress_client 直接 mmap 使用，运行时不做解析。
+ **/
+
+#define TRACE_MAGIC "ECHOTRC"
+#define TRACE_VERSION 1
+#define MAX_TRACE_MESSAGE_SIZE (1 << 20)
+
+struct TraceHeader
+{
+    char magic[8];             // "ECHOTRC\0"
+    uint32_t version;          // TRACE_VERSION
+    uint32_t connection_count; // 连接数
+    uint64_t record_count;     // 记录总数
+    uint32_t max_message_size; // 最大消息长度，用于预分配接收缓冲区
+    uint32_t reserved;
+};
+
+struct TraceConnection
+{
+    uint64_t first_record; // 第一条记录的下标
+    uint64_t record_count; // 记录条数
+};
+
+struct TraceRecord
+{
+    uint32_t size;   // 消息长度（字节）
+    uint32_t gap_us; // 距上一条消息发送的间隔（微秒）
+};
+
+static_assert(sizeof(TraceHeader) == 32, "unexpected TraceHeader layout");
+static_assert(sizeof(TraceConnection) == 16, "unexpected TraceConnection layout");
+static_assert(sizeof(TraceRecord) == 8, "unexpected TraceRecord layout");
+
+// 只读映射的负载轨迹
+class WorkloadTrace
+{
+private:
+    void *data;
+    size_t length;
+    const TraceHeader *header;
+    const TraceConnection *connections;
+    const TraceRecord *records;
+
+    bool fail(const std::string &path, const char *reason)
+    {
+        fprintf(stderr, "Invalid trace file %s: %s\n", path.c_str(), reason);
+        unmap();
+        return false;
+    }
+
+    void unmap()
+    {
+        if (data != nullptr)
+            munmap(data, length);
+        data = nullptr;
+        length = 0;
+        header = nullptr;
+        connections = nullptr;
+        records = nullptr;
+    }
+
+public:
+    WorkloadTrace()
+        : data(nullptr), length(0), header(nullptr), connections(nullptr), records(nullptr)
+    {
+    }
+
+    ~WorkloadTrace()
+    {
+        unmap();
+    }
+
+    WorkloadTrace(const WorkloadTrace &) = delete;
+    WorkloadTrace &operator=(const WorkloadTrace &) = delete;
+
+    // 映射并校验轨迹文件，失败时打印原因并返回false
+    bool open(const std::string &path)
+    {
+        unmap();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            perror("open");
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == -1)
+        {
+            perror("fstat");
+            close(fd);
+            return false;
+        }
+        if (st.st_size < (off_t)sizeof(TraceHeader))
+        {
+            close(fd);
+            return fail(path, "file too small");
+        }
+
+        length = st.st_size;
+        data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            data = nullptr;
+            perror("mmap");
+            return false;
+        }
+
+        header = static_cast<const TraceHeader *>(data);
+        if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0)
+            return fail(path, "bad magic");
+        if (header->version != TRACE_VERSION)
+            return fail(path, "unsupported version");
+        if (header->connection_count == 0)
+            return fail(path, "no connections");
+        if (header->max_message_size == 0 || header->max_message_size > MAX_TRACE_MESSAGE_SIZE)
+            return fail(path, "bad max message size");
+
+        uint64_t expected = sizeof(TraceHeader) +
+                            (uint64_t)header->connection_count * sizeof(TraceConnection) +
+                            header->record_count * sizeof(TraceRecord);
+        if (header->record_count > length / sizeof(TraceRecord) || expected != length)
+            return fail(path, "size does not match header");
+
+        connections = reinterpret_cast<const TraceConnection *>(header + 1);
+        records = reinterpret_cast<const TraceRecord *>(connections + header->connection_count);
+
+        for (uint32_t i = 0; i < header->connection_count; i++)
+        {
+            const TraceConnection &conn = connections[i];
+            if (conn.first_record > header->record_count ||
+                conn.record_count > header->record_count - conn.first_record)
+                return fail(path, "connection range out of bounds");
+        }
+        for (uint64_t i = 0; i < header->record_count; i++)
+        {
+            if (records[i].size == 0 || records[i].size > header->max_message_size)
+                return fail(path, "record size out of range");
+        }
+
+        // 回放时顺序访问记录
+        madvise(data, length, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    uint32_t connectionCount() const { return header->connection_count; }
+    uint64_t recordCount() const { return header->record_count; }
+    uint32_t maxMessageSize() const { return header->max_message_size; }
+
+    const TraceRecord *connectionRecords(uint32_t conn) const
+    {
+        return records + connections[conn].first_record;
+    }
+
+    uint64_t connectionRecordCount(uint32_t conn) const
+    {
+        return connections[conn].record_count;
+    }
+};
+
+#endif
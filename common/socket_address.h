@@ -0,0 +1,175 @@
+#ifndef SOCKET_ADDRESS_H
+#define SOCKET_ADDRESS_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/**
+ * 服务端监听与客户端连接共用的地址描述：
+ *
+ *   8888 / tcp4:8888 / tcp4:127.0.0.1:8888   IPv4 TCP
+ *   tcp6:8888 / tcp6:[::1]:8888               IPv6 TCP
+ *   unix:/tmp/echo.sock                       文件系统路径的Unix域套接字
+ *   unix:@echo                                抽象命名空间的Unix域套接字（Linux）
+ *
+ * 省略主机时，监听端使用通配地址，连接端使用回环地址。
+ **/
+struct SocketAddress
+{
+    std::string spec; // 规范化后的描述，用于日志和统计输出
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+
+    int family() const { return addr.ss_family; }
+
+    // 文件系统路径的Unix域套接字，监听端需要负责删除
+    bool isUnixPath() const
+    {
+        const struct sockaddr_un *un = reinterpret_cast<const struct sockaddr_un *>(&addr);
+        return addr.ss_family == AF_UNIX && un->sun_path[0] != '\0';
+    }
+};
+
+// 解析端口号，成功返回true
+static inline bool parsePort(const std::string &s, int &port)
+{
+    if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos || s.size() > 5)
+        return false;
+    port = atoi(s.c_str());
+    return port > 0 && port <= 65535;
+}
+
+/**
+ * 将地址描述解析为sockaddr
+ * passive: 为true时表示用于监听，省略的主机取通配地址
+ **/
+static inline bool parseSocketAddress(const std::string &spec, bool passive, SocketAddress &out)
+{
+    memset(&out.addr, 0, sizeof(out.addr));
+    out.addr_len = 0;
+
+    int port;
+    if (parsePort(spec, port))
+    {
+        // 纯端口号，兼容旧的命令行用法
+        return parseSocketAddress("tcp4:" + spec, passive, out);
+    }
+
+    if (spec.compare(0, 5, "tcp4:") == 0)
+    {
+        std::string rest = spec.substr(5);
+        std::string host = passive ? "0.0.0.0" : "127.0.0.1";
+        size_t colon = rest.rfind(':');
+        if (colon != std::string::npos)
+        {
+            host = rest.substr(0, colon);
+            rest = rest.substr(colon + 1);
+        }
+        if (!parsePort(rest, port))
+            return false;
+
+        struct sockaddr_in *in = reinterpret_cast<struct sockaddr_in *>(&out.addr);
+        in->sin_family = AF_INET;
+        in->sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &in->sin_addr) <= 0)
+            return false;
+        out.addr_len = sizeof(*in);
+        out.spec = "tcp4:" + host + ":" + rest;
+        return true;
+    }
+
+    if (spec.compare(0, 5, "tcp6:") == 0)
+    {
+        std::string rest = spec.substr(5);
+        std::string host = passive ? "::" : "::1";
+        if (!rest.empty() && rest[0] == '[')
+        {
+            size_t close_bracket = rest.find("]:");
+            if (close_bracket == std::string::npos)
+                return false;
+            host = rest.substr(1, close_bracket - 1);
+            rest = rest.substr(close_bracket + 2);
+        }
+        if (!parsePort(rest, port))
+            return false;
+
+        struct sockaddr_in6 *in6 = reinterpret_cast<struct sockaddr_in6 *>(&out.addr);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        if (inet_pton(AF_INET6, host.c_str(), &in6->sin6_addr) <= 0)
+            return false;
+        out.addr_len = sizeof(*in6);
+        out.spec = "tcp6:[" + host + "]:" + rest;
+        return true;
+    }
+
+    if (spec.compare(0, 5, "unix:") == 0)
+    {
+        std::string path = spec.substr(5);
+        struct sockaddr_un *un = reinterpret_cast<struct sockaddr_un *>(&out.addr);
+        // 抽象命名空间以'\0'开头，不计入路径结尾的'\0'
+        if (path.size() < 2 && (path.empty() || path[0] == '@'))
+            return false;
+        if (path.size() >= sizeof(un->sun_path))
+            return false;
+
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, path.c_str(), path.size());
+        if (path[0] == '@')
+        {
+            un->sun_path[0] = '\0';
+            out.addr_len = offsetof(struct sockaddr_un, sun_path) + path.size();
+        }
+        else
+        {
+            out.addr_len = offsetof(struct sockaddr_un, sun_path) + path.size() + 1;
+        }
+        out.spec = spec;
+        return true;
+    }
+
+    return false;
+}
+
+// 格式化对端地址，用于连接日志
+static inline std::string formatSockaddr(const struct sockaddr *sa, socklen_t len)
+{
+    char ip[INET6_ADDRSTRLEN];
+
+    switch (sa->sa_family)
+    {
+    case AF_INET:
+    {
+        const struct sockaddr_in *in = reinterpret_cast<const struct sockaddr_in *>(sa);
+        inet_ntop(AF_INET, &in->sin_addr, ip, sizeof(ip));
+        return std::string(ip) + ":" + std::to_string(ntohs(in->sin_port));
+    }
+    case AF_INET6:
+    {
+        const struct sockaddr_in6 *in6 = reinterpret_cast<const struct sockaddr_in6 *>(sa);
+        inet_ntop(AF_INET6, &in6->sin6_addr, ip, sizeof(ip));
+        return "[" + std::string(ip) + "]:" + std::to_string(ntohs(in6->sin6_port));
+    }
+    case AF_UNIX:
+    {
+        // 客户端通常不绑定地址
+        const struct sockaddr_un *un = reinterpret_cast<const struct sockaddr_un *>(sa);
+        size_t path_len = len > offsetof(struct sockaddr_un, sun_path) ? len - offsetof(struct sockaddr_un, sun_path) : 0;
+        if (path_len == 0)
+            return "unix:(unnamed)";
+        if (un->sun_path[0] == '\0')
+            return "unix:@" + std::string(un->sun_path + 1, path_len - 1);
+        return "unix:" + std::string(un->sun_path, strnlen(un->sun_path, path_len));
+    }
+    default:
+        return "unknown";
+    }
+}
+
+#endif
@@ -2,23 +2,67 @@
 #include <cstring>
 #include <sys/socket.h>
 #include <sys/epoll.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <signal.h>
 #include <cerrno>
 #include <ctime>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "socket_address.h"
 
 #define MAX_EVENTS 1024
 #define BUFFER_SIZE 4096
 #define DEFAULT_PORT 8888
 
+/**
+ * epoll_event.data.u64 的布局，避免在事件循环中按fd查表：
+ *   低32位: fd
+ *   32-62位: 所属listeners下标
+ *   63位: 是否为监听套接字
+ **/
+#define EVENT_LISTENER_FLAG (1ULL << 63)
+
+// 收到SIGINT/SIGTERM后退出事件循环，使析构函数能够清理unix:套接字文件
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handleStopSignal(int)
+{
+    stop_requested = 1;
+}
+
+static inline uint64_t makeEventData(int fd, size_t index, bool is_listener)
+{
+    return (uint64_t)(uint32_t)fd | ((uint64_t)index << 32) | (is_listener ? EVENT_LISTENER_FLAG : 0);
+}
+
+// 监听套接字及其独立的统计数据
+struct Listener
+{
+    SocketAddress addr;
+    int fd;
+    unsigned long long total_messages;
+    unsigned long long total_bytes;
+    unsigned long long total_connections;
+    unsigned long long active_connections;
+
+    Listener(const SocketAddress &a)
+        : addr(a), fd(-1), total_messages(0), total_bytes(0),
+          total_connections(0), active_connections(0)
+    {
+    }
+};
+
 class EchoServer
 {
 private:
-    int listen_fd;
+    std::vector<Listener> listeners;
     int epoll_fd;
-    int port;
     struct epoll_event *events;
 
     // 性能统计数据
@@ -46,44 +90,92 @@ private:
         return 0;
     }
 
+    // 探测路径上的套接字文件，只有连接被拒绝时才认为是遗留文件并删除
+    int removeStaleUnixSocket(const SocketAddress &addr)
+    {
+        const struct sockaddr_un *un = reinterpret_cast<const struct sockaddr_un *>(&addr.addr);
+        struct stat st;
+        if (lstat(un->sun_path, &st) == -1 || !S_ISSOCK(st.st_mode))
+        {
+            // 不存在或不是套接字文件，交给bind报错
+            return 0;
+        }
+
+        // 非阻塞探测：对方backlog已满时connect不会阻塞启动过程
+        int probe_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (probe_fd == -1)
+        {
+            perror("socket");
+            return -1;
+        }
+
+        int ret = connect(probe_fd, (const struct sockaddr *)&addr.addr, addr.addr_len);
+        int saved_errno = errno;
+        close(probe_fd);
+
+        if (ret == 0 || saved_errno == EAGAIN)
+        {
+            std::cerr << "bind: Address already in use (" << addr.spec << ")" << std::endl;
+            return -1;
+        }
+        if (saved_errno == ECONNREFUSED)
+        {
+            unlink(un->sun_path);
+        }
+        return 0;
+    }
+
     // 创建并绑定监听套接字
-    int createListenSocket()
+    int createListenSocket(Listener &listener)
     {
+        const SocketAddress &addr = listener.addr;
+
         /**
-         * AF_INET: IPv4协议
+         * family: AF_INET / AF_INET6 / AF_UNIX，由监听描述决定
          * SOCK_STREAM: 提供有序、可靠、双向、基于连接的字节流。
          * 0: 给定套接字类型的默认协议
          **/
-        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int listen_fd = socket(addr.family(), SOCK_STREAM, 0);
         if (listen_fd == -1)
         {
             perror("socket");
             return -1;
         }
 
-        // 设置地址复用
         int opt = 1;
-        /**
-         * SOL_SOCKET: 套接字级别选项
-         * SO_REUSEADDR: 允许重用本地地址和端口
-         **/
-        if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1)
+        if (addr.family() != AF_UNIX)
+        {
+            // 设置地址复用
+            /**
+             * SOL_SOCKET: 套接字级别选项
+             * SO_REUSEADDR: 允许重用本地地址和端口
+             **/
+            if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1)
+            {
+                perror("setsockopt");
+                close(listen_fd);
+                return -1;
+            }
+        }
+
+        // 仅接受IPv6连接，使tcp4和tcp6可以同时监听同一端口
+        if (addr.family() == AF_INET6 &&
+            setsockopt(listen_fd, IPPROTO_IPV6, IPV6_V6ONLY, &opt, sizeof(opt)) == -1)
+        {
+            perror("setsockopt IPV6_V6ONLY");
+            close(listen_fd);
+            return -1;
+        }
+
+        // 删除上次运行遗留的套接字文件：仍有进程在监听时视为地址已被占用
+        if (addr.isUnixPath() && removeStaleUnixSocket(addr) == -1)
         {
-            perror("setsockopt");
             close(listen_fd);
             return -1;
         }
 
         // 绑定套接字
-        struct sockaddr_in server_addr;
-        memset(&server_addr, 0, sizeof(server_addr));
-        // 设置地址族、IP地址和端口号
-        server_addr.sin_family = AF_INET;
-        // 监听所有可用接口
-        server_addr.sin_addr.s_addr = INADDR_ANY;
-        server_addr.sin_port = htons(port);
-
-        if (bind(listen_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1)
+        if (bind(listen_fd, (const struct sockaddr *)&addr.addr, addr.addr_len) == -1)
         {
             perror("bind");
             close(listen_fd);
@@ -108,18 +200,21 @@ private:
             return -1;
         }
 
+        listener.fd = listen_fd;
         return 0;
     }
 
     // 处理新连接
-    void handleAccept()
+    void handleAccept(size_t index)
     {
+        Listener &listener = listeners[index];
+
         while (true)
         {
-            struct sockaddr_in client_addr;
+            struct sockaddr_storage client_addr;
             socklen_t client_len = sizeof(client_addr);
 
-            int client_fd = accept(listen_fd, (struct sockaddr *)&client_addr, &client_len);
+            int client_fd = accept(listener.fd, (struct sockaddr *)&client_addr, &client_len);
             if (client_fd == -1)
             {
                 if (errno == EAGAIN || errno == EWOULDBLOCK)
@@ -135,8 +230,8 @@ private:
             }
 
             std::cout << "New connection from "
-                      << inet_ntoa(client_addr.sin_addr) << ":"
-                      << ntohs(client_addr.sin_port)
+                      << formatSockaddr((struct sockaddr *)&client_addr, client_len)
+                      << " on " << listener.addr.spec
                       << " (fd=" << client_fd << ")" << std::endl;
 
             // 设置非阻塞模式
@@ -153,19 +248,24 @@ private:
              * EPOLLET: 边缘触发模式（即只在状态改变时通知）
              **/
             ev.events = EPOLLIN | EPOLLET;
-            ev.data.fd = client_fd;
+            ev.data.u64 = makeEventData(client_fd, index, false);
             if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &ev) == -1)
             {
                 perror("epoll_ctl: client_fd");
                 close(client_fd);
+                continue;
             }
+
+            listener.total_connections++;
+            listener.active_connections++;
         }
     }
 
     // 处理客户端数据
-    void handleClient(int client_fd)
+    void handleClient(int client_fd, size_t index)
     {
         char buffer[BUFFER_SIZE];
+        Listener &listener = listeners[index];
 
         while (true)
         {
@@ -188,7 +288,7 @@ private:
                         else
                         {
                             perror("write");
-                            closeClient(client_fd);
+                            closeClient(client_fd, index);
                             return;
                         }
                     }
@@ -198,6 +298,8 @@ private:
                 // 更新统计信息
                 total_messages++;
                 total_bytes += n;
+                listener.total_messages++;
+                listener.total_bytes += n;
 
                 // 记录首次消息时间
                 if (!has_traffic)
@@ -211,7 +313,7 @@ private:
             {
                 // 客户端关闭连接
                 std::cout << "Client disconnected (fd=" << client_fd << ")" << std::endl;
-                closeClient(client_fd);
+                closeClient(client_fd, index);
                 break;
             }
             else
@@ -224,7 +326,7 @@ private:
                 else
                 {
                     perror("read");
-                    closeClient(client_fd);
+                    closeClient(client_fd, index);
                     break;
                 }
             }
@@ -232,8 +334,10 @@ private:
     }
 
     // 关闭客户端连接
-    void closeClient(int client_fd)
+    void closeClient(int client_fd, size_t index)
     {
+        listeners[index].active_connections--;
+
         epoll_ctl(epoll_fd, EPOLL_CTL_DEL, client_fd, nullptr);
         close(client_fd);
     }
@@ -266,24 +370,51 @@ private:
             std::cout << "Total bytes: " << total_bytes << std::endl;
             std::cout << "Messages/sec: " << (total_messages / elapsed) << std::endl;
             std::cout << "Throughput: " << (total_bytes / elapsed / 1024.0) << " KB/s" << std::endl;
+
+            // 各监听地址的统计
+            if (listeners.size() > 1)
+            {
+                for (size_t i = 0; i < listeners.size(); i++)
+                {
+                    const Listener &l = listeners[i];
+                    std::cout << "[" << l.addr.spec << "] connections: " << l.active_connections
+                              << "/" << l.total_connections
+                              << ", messages: " << l.total_messages
+                              << ", Messages/sec: " << (l.total_messages / elapsed)
+                              << ", Throughput: " << (l.total_bytes / elapsed / 1024.0) << " KB/s" << std::endl;
+                }
+            }
             std::cout << "========================\n"
                       << std::endl;
         }
     }
 
 public:
-    EchoServer(int p = DEFAULT_PORT)
-        : listen_fd(-1), epoll_fd(-1), port(p), events(nullptr),
+    EchoServer(const std::vector<SocketAddress> &addrs)
+        : epoll_fd(-1), events(nullptr),
           total_messages(0), total_bytes(0), has_traffic(false)
     {
+        for (size_t i = 0; i < addrs.size(); i++)
+        {
+            listeners.push_back(Listener(addrs[i]));
+        }
         start_time = time(nullptr);
         first_message_time = 0;
     }
 
     ~EchoServer()
     {
-        if (listen_fd != -1)
-            close(listen_fd);
+        for (size_t i = 0; i < listeners.size(); i++)
+        {
+            if (listeners[i].fd == -1)
+                continue;
+            close(listeners[i].fd);
+            if (listeners[i].addr.isUnixPath())
+            {
+                const struct sockaddr_un *un = reinterpret_cast<const struct sockaddr_un *>(&listeners[i].addr.addr);
+                unlink(un->sun_path);
+            }
+        }
         if (epoll_fd != -1)
             close(epoll_fd);
         if (events != nullptr)
@@ -292,14 +423,6 @@ public:
 
     int start()
     {
-        // 创建监听套接字
-        if (createListenSocket() == -1)
-        {
-            return -1;
-        }
-
-        std::cout << "Echo server listening on port " << port << std::endl;
-
         // 创建epoll实例
         epoll_fd = epoll_create1(0);
         if (epoll_fd == -1)
@@ -308,14 +431,26 @@ public:
             return -1;
         }
 
-        // 将监听套接字添加到epoll实例中
-        struct epoll_event ev;
-        ev.events = EPOLLIN;
-        ev.data.fd = listen_fd;
-        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) == -1)
+        for (size_t i = 0; i < listeners.size(); i++)
         {
-            perror("epoll_ctl: listen_fd");
-            return -1;
+            // 创建监听套接字
+            if (createListenSocket(listeners[i]) == -1)
+            {
+                std::cerr << "Failed to listen on " << listeners[i].addr.spec << std::endl;
+                return -1;
+            }
+
+            // 将监听套接字添加到epoll实例中
+            struct epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.u64 = makeEventData(listeners[i].fd, i, true);
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listeners[i].fd, &ev) == -1)
+            {
+                perror("epoll_ctl: listen_fd");
+                return -1;
+            }
+
+            std::cout << "Echo server listening on " << listeners[i].addr.spec << std::endl;
         }
 
         // 分配事件数组
@@ -323,13 +458,13 @@ public:
 
         // 事件循环
         time_t last_stats_time = time(nullptr);
-        while (true)
+        while (!stop_requested)
         {
             int nfds = epoll_wait(epoll_fd, events, MAX_EVENTS, 1000); // 1秒超时
 
             if (nfds == -1)
             {
-                // 被信号中断，继续等待
+                // 被信号中断，回到循环条件检查是否需要退出
                 if (errno == EINTR)
                 {
                     continue;
@@ -341,15 +476,18 @@ public:
             // 处理事件
             for (int i = 0; i < nfds; i++)
             {
-                if (events[i].data.fd == listen_fd)
+                uint64_t data = events[i].data.u64;
+                int fd = (int)(uint32_t)data;
+                size_t index = (size_t)((data & ~EVENT_LISTENER_FLAG) >> 32);
+                if (data & EVENT_LISTENER_FLAG)
                 {
                     // 新连接
-                    handleAccept();
+                    handleAccept(index);
                 }
                 else
                 {
                     // 客户端数据
-                    handleClient(events[i].data.fd);
+                    handleClient(fd, index);
                 }
             }
 
@@ -362,24 +500,44 @@ public:
             }
         }
 
+        std::cout << "Shutting down." << std::endl;
         return 0;
     }
 };
 
 int main(int argc, char *argv[])
 {
-    int port = DEFAULT_PORT;
+    std::vector<SocketAddress> addrs;
 
-    if (argc > 1)
+    // 每个参数是一个监听描述：端口号、tcp4:、tcp6:、unix:/path 或 unix:@name
+    for (int i = 1; i < argc; i++)
     {
-        port = atoi(argv[1]);
-        if (port <= 0 || port > 65535)
+        SocketAddress addr;
+        if (!parseSocketAddress(argv[i], true, addr))
         {
-            std::cerr << "Invalid port number" << std::endl;
+            std::cerr << "Invalid listen address: " << argv[i] << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [port | tcp4:[host:]port | tcp6:[[host]:]port | unix:/path | unix:@name]..." << std::endl;
             return 1;
         }
+        addrs.push_back(addr);
     }
 
-    EchoServer server(port);
+    if (addrs.empty())
+    {
+        SocketAddress addr;
+        parseSocketAddress(std::to_string(DEFAULT_PORT), true, addr);
+        addrs.push_back(addr);
+    }
+
+    // 注册退出信号；忽略SIGPIPE，客户端异常断开时write返回EPIPE而不是终止进程
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handleStopSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    EchoServer server(addrs);
     return server.start();
 }
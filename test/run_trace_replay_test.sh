@@ -0,0 +1,13 @@
+#!/bin/bash
+# run_trace_replay_test.sh
+
+NUM_CONNECTIONS=$1
+MESSAGE_COUNT=$2
+SPEED=${3:-1}
+TRACE_FILE=$(mktemp /tmp/echo_trace.XXXXXX)
+
+../build/trace_convert -o $TRACE_FILE -c $NUM_CONNECTIONS -n $MESSAGE_COUNT -a 1.5 -s 64 -S 4096 -r 1000 || { rm -f $TRACE_FILE; exit 1; }
+../build/stress_client -h 127.0.0.1 -p 8888 -t $TRACE_FILE -x $SPEED
+
+rm -f $TRACE_FILE
+echo "轨迹回放测试完成"
@@ -0,0 +1,22 @@
+#!/bin/bash
+# run_transport_compare_test.sh
+
+MESSAGE_COUNT=${1:-10000}
+MESSAGE_SIZE=${2:-1024}
+PORT=8889
+UNIX_PATH=/tmp/echo_server_test.sock
+
+../build/echo_server tcp4:$PORT tcp6:$PORT unix:$UNIX_PATH > /dev/null &
+SERVER_PID=$!
+sleep 1
+
+for ADDRESS in tcp4:127.0.0.1:$PORT "tcp6:[::1]:$PORT" unix:$UNIX_PATH
+do
+    echo "===== $ADDRESS ====="
+    ../build/stress_client -a "$ADDRESS" -s $MESSAGE_SIZE -n $MESSAGE_COUNT | grep -E "Server|Failed|P50|P99|Messages/sec"
+done
+
+kill $SERVER_PID
+wait $SERVER_PID 2>/dev/null
+rm -f $UNIX_PATH
+echo "TCP与UDS延迟对比测试完成"